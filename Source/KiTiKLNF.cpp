@@ -83,7 +83,16 @@ void Laf::drawRotarySlider(juce::Graphics& g, int x, int y, int width, int heigh
 
     auto str = String('none');
     auto value = slider.getValue();
-    if (value <= 1) {
+    if (slider.getProperties()[Laf::choiceProperty]) {
+        //choice knobs show the choice text instead
+        str = slider.getTextFromValue(value);
+    }
+    else if (slider.getMinimum() < 0) {
+        //anything that can go negative is a level
+        str = String(value);
+        str.append(" dB", 3);
+    }
+    else if (value <= 1) {
         value *= 100;
         str = String(value);
         str.append("%", 3);
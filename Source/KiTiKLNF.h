@@ -14,6 +14,9 @@ struct Laf : juce::LookAndFeel_V4 {
 
     Laf() {}
 
+    //set this property on a slider attached to a choice parameter so its knob shows the choice text
+    static constexpr const char* choiceProperty = "choice";
+
     void drawRotarySlider(juce::Graphics& g, int x, int y, int width, int height,
         float sliderPos, float rotaryStartAngle, float rotaryEndAngle, juce::Slider& slider) override;
     void drawToggleButton(juce::Graphics& g, juce::ToggleButton& button,
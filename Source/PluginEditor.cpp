@@ -13,7 +13,9 @@
 SimpleReverbAudioProcessorEditor::SimpleReverbAudioProcessorEditor (SimpleReverbAudioProcessor& p)
     : AudioProcessorEditor (&p), audioProcessor (p), roomSizeAT(audioProcessor.apvts, "roomSize", roomSize),
     dampingAT(audioProcessor.apvts, "damping", damping), dryWetAT(audioProcessor.apvts, "dryWet", dryWet),
-    widthAT(audioProcessor.apvts, "width", width), freezeAT(audioProcessor.apvts, "freeze", freeze)
+    widthAT(audioProcessor.apvts, "width", width), duckAT(audioProcessor.apvts, "duck", duck),
+    duckThresholdAT(audioProcessor.apvts, "duckThreshold", duckThreshold),
+    gateAT(audioProcessor.apvts, "gate", gate), outputAT(audioProcessor.apvts, "output", output), freezeAT(audioProcessor.apvts, "freeze", freeze)
 {
     setLookAndFeel(&lnf);
 
@@ -42,6 +44,30 @@ SimpleReverbAudioProcessorEditor::SimpleReverbAudioProcessorEditor (SimpleReverb
     dryWet.setName("Dry/Wet");
     addAndMakeVisible(dryWet);
 
+    duck.setSliderStyle(juce::Slider::RotaryHorizontalVerticalDrag);
+    duck.setTextBoxStyle(juce::Slider::NoTextBox, false, 100, 20);
+    duck.setName("Duck");
+    addAndMakeVisible(duck);
+
+    duckThreshold.setSliderStyle(juce::Slider::RotaryHorizontalVerticalDrag);
+    duckThreshold.setTextBoxStyle(juce::Slider::NoTextBox, false, 100, 20);
+    duckThreshold.setName("Threshold");
+    duckThreshold.setTooltip("Input level where ducking reaches its full depth");
+    addAndMakeVisible(duckThreshold);
+
+    gate.setSliderStyle(juce::Slider::RotaryHorizontalVerticalDrag);
+    gate.setTextBoxStyle(juce::Slider::NoTextBox, false, 100, 20);
+    gate.setName("Gate");
+    gate.getProperties().set(Laf::choiceProperty, true);
+    addAndMakeVisible(gate);
+
+    output.setSliderStyle(juce::Slider::RotaryHorizontalVerticalDrag);
+    output.setTextBoxStyle(juce::Slider::NoTextBox, false, 100, 20);
+    output.setName("Output");
+    output.getProperties().set(Laf::choiceProperty, true);
+    output.setTooltip("Binaural only applies to stereo outputs, ambisonic outputs are always encoded");
+    addAndMakeVisible(output);
+
     freeze.setToggleState(false, juce::dontSendNotification);
     freeze.setButtonText("Freeze");
     addAndMakeVisible(freeze);
@@ -49,8 +75,10 @@ SimpleReverbAudioProcessorEditor::SimpleReverbAudioProcessorEditor (SimpleReverb
     freeze.setClickingTogglesState(true);
     freeze.setTooltip("Freeze");
 
-    setSize (800, 250);
+    setSize (1200, 250);
     
+    assetLoader.startThread();
+
     startTimerHz(24);
 }
 
@@ -59,6 +87,29 @@ SimpleReverbAudioProcessorEditor::~SimpleReverbAudioProcessorEditor()
     setLookAndFeel(nullptr);
 }
 
+void SimpleReverbAudioProcessorEditor::AssetLoader::run()
+{
+    //ImageCache is shared, so only the first editor of a session pays for the png decode
+    logo = juce::ImageCache::getFromMemory(BinaryData::KITIK_LOGO_NO_BKGD_png, BinaryData::KITIK_LOGO_NO_BKGD_pngSize);
+    typeface = juce::Typeface::createSystemTypefaceFor(BinaryData::OFFSHORE_TTF, BinaryData::OFFSHORE_TTFSize);
+    finished = true;
+}
+
+void SimpleReverbAudioProcessorEditor::assetsLoaded()
+{
+    auto& logo = assetLoader.logo;
+    freeze.setImages(true, true, true, logo, 0, juce::Colours::white, juce::Image(), 0, juce::Colours::white, juce::Image(), 0, juce::Colour(64u, 194u, 230u));
+
+    titleFont = juce::Font(assetLoader.typeface);
+    titleFont.setHeight(30.f);
+    assetsReady = true;
+
+    tt = std::make_unique<juce::TooltipWindow>(this, 1000);
+
+    resized();
+    repaint();
+}
+
 //==============================================================================
 void SimpleReverbAudioProcessorEditor::paint (juce::Graphics& g)
 {
@@ -70,42 +121,20 @@ void SimpleReverbAudioProcessorEditor::paint (juce::Graphics& g)
     g.setGradientFill(grad);
     g.fillAll();
 
-    auto inputMeter = bounds.removeFromLeft(bounds.getWidth() * .1);
-    auto meterLSide = inputMeter.removeFromLeft(inputMeter.getWidth() * .5);
-    meter[0].setBounds(meterLSide);
-    meter[1].setBounds(inputMeter);
+    if (!assetsReady)
+        return;
 
-    auto outputMeter = bounds.removeFromRight(bounds.getWidth() * .11);
-    auto outMeterLSide = outputMeter.removeFromLeft(outputMeter.getWidth() * .5);
-    outMeter[0].setBounds(outMeterLSide);
-    outMeter[1].setBounds(outputMeter);
+    bounds.removeFromLeft(bounds.getWidth() * .1);
+    bounds.removeFromRight(bounds.getWidth() * .11);
 
     //Making space for logo and text without distorting
     auto infoSpace = bounds.removeFromTop(bounds.getHeight() * .3);
     auto logoSpace = infoSpace.removeFromLeft(bounds.getWidth() * .425);
     auto textSpace = infoSpace.removeFromRight(bounds.getWidth() * .425);
 
-    juce::FlexBox flexbox;
-    flexbox.flexDirection = juce::FlexBox::Direction::row;
-    flexbox.flexWrap = juce::FlexBox::Wrap::noWrap;
-
-    flexbox.items.add(juce::FlexItem(roomSize).withFlex(1.f));
-    flexbox.items.add(juce::FlexItem(damping).withFlex(1.f));
-    flexbox.items.add(juce::FlexItem(width).withFlex(1.f));
-    flexbox.items.add(juce::FlexItem(dryWet).withFlex(1.f));
-
-    flexbox.performLayout(bounds);
-   
-    //add logo
-    auto logo = juce::ImageCache::getFromMemory(BinaryData::KITIK_LOGO_NO_BKGD_png, BinaryData::KITIK_LOGO_NO_BKGD_pngSize);
-    freeze.setImages(true, true, true, logo, 0, juce::Colours::white, juce::Image(), 0, juce::Colours::white, juce::Image(), 0, juce::Colour(64u, 194u, 230u));
-    freeze.setBounds(infoSpace);
-
     //Add Text
-    auto newFont = juce::Font(juce::Typeface::createSystemTypefaceFor(BinaryData::OFFSHORE_TTF, BinaryData::OFFSHORE_TTFSize));
     g.setColour(juce::Colours::whitesmoke);
-    g.setFont(newFont);
-    g.setFont(30.f);
+    g.setFont(titleFont);
     g.drawFittedText("Simple", logoSpace, juce::Justification::centredRight, 1);
     g.drawFittedText("Reverb", textSpace, juce::Justification::centredLeft, 1);
 
@@ -115,18 +144,21 @@ void SimpleReverbAudioProcessorEditor::resized()
 {
     auto bounds = getLocalBounds();
 
-    auto inputMeter = bounds.removeFromLeft(bounds.getWidth() * .05);
+    auto inputMeter = bounds.removeFromLeft(bounds.getWidth() * .1);
     auto meterLSide = inputMeter.removeFromLeft(inputMeter.getWidth() * .5);
     meter[0].setBounds(meterLSide);
     meter[1].setBounds(inputMeter);
 
-    auto outputMeter = bounds.removeFromRight(bounds.getWidth() * .053);
+    auto outputMeter = bounds.removeFromRight(bounds.getWidth() * .11);
     auto outMeterLSide = outputMeter.removeFromLeft(outputMeter.getWidth() * .5);
     outMeter[0].setBounds(outMeterLSide);
     outMeter[1].setBounds(outputMeter);
 
-    auto logoSpace = bounds.removeFromTop(bounds.getHeight() * .1);
-    
+    //Making space for logo and text without distorting
+    auto infoSpace = bounds.removeFromTop(bounds.getHeight() * .3);
+    infoSpace.removeFromLeft(bounds.getWidth() * .425);
+    infoSpace.removeFromRight(bounds.getWidth() * .425);
+
     juce::FlexBox flexbox;
     flexbox.flexDirection = juce::FlexBox::Direction::row;
     flexbox.flexWrap = juce::FlexBox::Wrap::noWrap;
@@ -135,13 +167,24 @@ void SimpleReverbAudioProcessorEditor::resized()
     flexbox.items.add(juce::FlexItem(damping).withFlex(1.f));
     flexbox.items.add(juce::FlexItem(width).withFlex(1.f));
     flexbox.items.add(juce::FlexItem(dryWet).withFlex(1.f));
+    flexbox.items.add(juce::FlexItem(duck).withFlex(1.f));
+    flexbox.items.add(juce::FlexItem(duckThreshold).withFlex(1.f));
+    flexbox.items.add(juce::FlexItem(gate).withFlex(1.f));
+    flexbox.items.add(juce::FlexItem(output).withFlex(1.f));
 
     flexbox.performLayout(bounds);
 
+    freeze.setBounds(infoSpace);
+    freeze.setVisible(assetsReady);
+
 }
 
 void SimpleReverbAudioProcessorEditor::timerCallback()
 {
+    if (!assetsReady && assetLoader.finished) {
+        assetsLoaded();
+    }
+
     //these get our rms level, and the set level function tells you how much of the rect you want
     for (auto channel = 0; channel < audioProcessor.getTotalNumInputChannels(); channel++) {
         meter[channel].setLevel(audioProcessor.getRMS(channel));
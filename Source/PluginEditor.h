@@ -29,17 +29,41 @@ public:
 
 private:
 
+    //decodes the embedded logo and font off the message thread. The editor owns it and joins it
+    //on close, and picks the results up from its own timer so nothing is left queued behind it.
+    struct AssetLoader : juce::Thread
+    {
+        AssetLoader() : juce::Thread("SimpleReverb assets") {}
+        ~AssetLoader() override { stopThread(-1); }
+
+        void run() override;
+
+        juce::Image logo;
+        juce::Typeface::Ptr typeface;
+        std::atomic<bool> finished{ false };
+    };
+
+    void assetsLoaded();
+
     SimpleReverbAudioProcessor& audioProcessor;
     Laf lnf;
     std::array<Laf::LevelMeter, 2> meter;
     std::array<Laf::LevelMeter, 2> outMeter;
 
-    juce::Slider roomSize, damping, dryWet, width;
+    juce::Slider roomSize, damping, dryWet, width, duck, duckThreshold, gate, output;
     juce::ImageButton freeze;
 
-    juce::AudioProcessorValueTreeState::SliderAttachment roomSizeAT, dampingAT, dryWetAT, widthAT;
+    //attachments stay eager, they set the knob positions and the first frame has to show the real values
+    juce::AudioProcessorValueTreeState::SliderAttachment roomSizeAT, dampingAT, dryWetAT, widthAT, duckAT, duckThresholdAT, gateAT, outputAT;
     juce::AudioProcessorValueTreeState::ButtonAttachment freezeAT;
-    juce::TooltipWindow tt {this, 1000};
+
+    //nothing can hover before the first frame is up, so the tooltip window is made along with the assets
+    std::unique_ptr<juce::TooltipWindow> tt;
+
+    //until these are decoded the editor paints a placeholder frame without the title and logo
+    AssetLoader assetLoader;
+    juce::Font titleFont;
+    bool assetsReady{ false };
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (SimpleReverbAudioProcessorEditor)
 };
@@ -22,12 +22,6 @@ SimpleReverbAudioProcessor::SimpleReverbAudioProcessor()
                        )
 #endif
 {
-    roomSize = dynamic_cast<juce::AudioParameterFloat*>(apvts.getParameter("roomSize"));
-    damping = dynamic_cast<juce::AudioParameterFloat*>(apvts.getParameter("damping"));
-    dryWet = dynamic_cast<juce::AudioParameterFloat*>(apvts.getParameter("dryWet"));
-    width = dynamic_cast<juce::AudioParameterFloat*>(apvts.getParameter("width"));
-    freeze = dynamic_cast<juce::AudioParameterBool*>(apvts.getParameter("freeze"));
-
 }
 
 SimpleReverbAudioProcessor::~SimpleReverbAudioProcessor()
@@ -102,14 +96,35 @@ void SimpleReverbAudioProcessor::prepareToPlay(double sampleRate, int samplesPer
     // Use this method as the place to do any pre-playback
     // initialisation that you need..
 
+    subBlockSize = juce::jlimit(1, maxSubBlockSize, samplesPerBlock);
+
     juce::dsp::ProcessSpec spec;
-    spec.maximumBlockSize = samplesPerBlock;
+    spec.maximumBlockSize = subBlockSize;
     spec.numChannels = 1;
     spec.sampleRate = sampleRate;
 
     reverb.reset();
     reverb.prepare(spec);
 
+    auto numSources = juce::jmin(getTotalNumInputChannels(), 2);
+    spatial.prepare(sampleRate, subBlockSize, numSources, getChannelLayoutOfBus(false, 0).getAmbisonicOrder());
+    spatial.reset();
+
+    //one pole coefficients for the ducking envelope, fast attack and a slower release so the tail swells back in
+    duckAttack = std::exp(-1.f / (0.005f * (float)sampleRate));
+    duckRelease = std::exp(-1.f / (0.15f * (float)sampleRate));
+    duckEnv.fill(0.f);
+    gateBeats = 0.0;
+
+    //meters are published about every 20ms, the editor only polls them at 24Hz
+    meterWindow = juce::jmax(1, (int)(sampleRate * 0.02));
+    meterSumIn.fill(0.f);
+    meterSumOut.fill(0.f);
+    meterSamples = 0;
+
+    controlSamples = 0;
+    paramsDirty = true;
+
 }
 
 void SimpleReverbAudioProcessor::releaseResources()
@@ -126,13 +141,18 @@ bool SimpleReverbAudioProcessor::isBusesLayoutSupported (const BusesLayout& layo
     return true;
   #else
     // This is the place where you check if the layout is supported.
-    // In this template code we only support mono or stereo.
+    // The reverb itself runs on a mono or stereo input. The output either
+    // matches that, or is a first or third order ambisonic bus.
     // Some plugin hosts, such as certain GarageBand versions, will only
     // load plugins that support stereo bus layouts.
-    if (layouts.getMainOutputChannelSet() != juce::AudioChannelSet::mono()
-     && layouts.getMainOutputChannelSet() != juce::AudioChannelSet::stereo())
+    if (layouts.getMainInputChannelSet() != juce::AudioChannelSet::mono()
+     && layouts.getMainInputChannelSet() != juce::AudioChannelSet::stereo())
         return false;
 
+    if (layouts.getMainOutputChannelSet() == juce::AudioChannelSet::ambisonic(1)
+     || layouts.getMainOutputChannelSet() == juce::AudioChannelSet::ambisonic(SpatialRenderer::maxAmbisonicOrder))
+        return true;
+
     // This checks if the input layout matches the output layout
    #if ! JucePlugin_IsSynth
     if (layouts.getMainOutputChannelSet() != layouts.getMainInputChannelSet())
@@ -150,35 +170,176 @@ void SimpleReverbAudioProcessor::processBlock(juce::AudioBuffer<float>& buffer,
     auto totalNumInputChannels = getTotalNumInputChannels();
     auto totalNumOutputChannels = getTotalNumOutputChannels();
 
-    //rms levels for meters
-    for (auto channel = 0; channel < totalNumInputChannels; channel++) {
-        rmsIn[channel] = juce::Decibels::gainToDecibels(buffer.getRMSLevel(channel, 0, buffer.getNumSamples()));
-        if (rmsIn[channel] < -60) { rmsIn[channel] = -60; }
-    }
+    auto numSamples = buffer.getNumSamples();
+    auto numChannels = juce::jmin(totalNumInputChannels, (int)rmsIn.size());
 
     for (auto i = totalNumInputChannels; i < totalNumOutputChannels; ++i)
-        buffer.clear(i, 0, buffer.getNumSamples());
-
-    params.damping = damping->get();
-    params.dryLevel = (1 - dryWet->get());
-    params.wetLevel = dryWet->get();
-    params.freezeMode = freeze->get();
-    params.roomSize = roomSize->get();
-    params.width = width->get();
+        buffer.clear(i, 0, numSamples);
 
-    reverb.setParameters(params);
+    //only take a new snapshot when a control tick lands somewhere in this block
+    if (paramsDirty || controlSamples + numSamples >= controlInterval) {
+        readParameters();
+    }
 
     juce::dsp::AudioBlock<float> block(buffer);
-    juce::dsp::ProcessContextReplacing<float> context(block);
+    auto tankBlock = block.getSubsetChannelBlock(0, (size_t)numChannels);
+
+    //the reverb only ever sees sub blocks of the prepared size, no matter what the host hands us
+    for (auto offset = 0; offset < numSamples; offset += subBlockSize) {
+        auto length = juce::jmin(subBlockSize, numSamples - offset);
+
+        //the ducking envelope and the meter sums share one pass over the input
+        auto duckLevel = 0.f;
+        for (auto channel = 0; channel < numChannels; channel++) {
+            auto* data = buffer.getReadPointer(channel, offset);
+            auto env = duckEnv[channel];
+            auto sumSquares = 0.f;
+
+            for (auto i = 0; i < length; i++) {
+                auto x = std::abs(data[i]);
+                sumSquares += x * x;
+                env = x + (x > env ? duckAttack : duckRelease) * (env - x);
+            }
+
+            duckEnv[channel] = env;
+            duckLevel = juce::jmax(duckLevel, env);
+            meterSumIn[channel] += sumSquares;
+        }
+
+        controlSamples += length;
+        if (paramsDirty || controlSamples >= controlInterval) {
+            controlSamples = 0;
+            updateReverbParameters(duckLevel);
+        }
+
+        advanceGate(length);
+
+        auto subBlock = tankBlock.getSubBlock((size_t)offset, (size_t)length);
+        juce::dsp::ProcessContextReplacing<float> context(subBlock);
+
+        reverb.process(context);
+
+        for (auto channel = 0; channel < numChannels; channel++) {
+            auto* data = buffer.getReadPointer(channel, offset);
+            for (auto i = 0; i < length; i++) {
+                meterSumOut[channel] += data[i] * data[i];
+            }
+        }
+
+        //meters show the tank itself, the spatial render happens after them
+        spatial.process(block.getSubBlock((size_t)offset, (size_t)length), binaural);
+    }
+
+    //rms levels for meters, only converted once enough samples are in so tiny blocks don't pay for it
+    meterSamples += numSamples;
+    if (meterSamples >= meterWindow) {
+        for (auto channel = 0; channel < numChannels; channel++) {
+            rmsIn[channel] = juce::jmax(-60.f, juce::Decibels::gainToDecibels(std::sqrt(meterSumIn[channel] / meterSamples)));
+            rmsOut[channel] = juce::jmax(-60.f, juce::Decibels::gainToDecibels(std::sqrt(meterSumOut[channel] / meterSamples)));
+        }
+
+        meterSumIn.fill(0.f);
+        meterSumOut.fill(0.f);
+        meterSamples = 0;
+    }
 
-    reverb.process(context);
+}
 
-    //rms levels for meters
-    for (auto channel = 0; channel < totalNumInputChannels; channel++) {
-        rmsOut[channel] = juce::Decibels::gainToDecibels(buffer.getRMSLevel(channel, 0, buffer.getNumSamples()));
-        if (rmsOut[channel] < -60) { rmsOut[channel] = -60; }
+void SimpleReverbAudioProcessor::readParameters()
+{
+    targetParams.damping = damping.get();
+    targetParams.dryLevel = (1 - dryWet.get());
+    targetParams.freezeMode = freeze.get();
+    targetParams.roomSize = roomSize.get();
+    targetParams.width = width.get();
+
+    dryWetLevel = dryWet.get();
+    duckAmount = duck.get();
+    duckThresholdDb = duckThreshold.get();
+    binaural = output.getIndex() == 1;
+
+    //the playhead is a call into the host, so only make it while the gate is actually running
+    gateDivision = gate.getIndex();
+    if (gateDivision != 0) {
+        syncGate();
     }
+}
 
+void SimpleReverbAudioProcessor::updateReverbParameters(float duckLevel)
+{
+    auto duckGain = getDuckGain(duckLevel, duckAmount, duckThresholdDb);
+    targetParams.wetLevel = dryWetLevel * duckGain * getGateGain(gateBeats, gateDivision);
+
+    //once the duck has fully released the level is exactly where it rests, so that always goes through
+    auto released = duckGain == 1.f && targetParams.wetLevel != params.wetLevel;
+
+    //setParameters recomputes the gain and damping targets, so skip it when nothing moved
+    if (paramsDirty || released || !paramsEqual(targetParams, params)) {
+        params = targetParams;
+        reverb.setParameters(params);
+        paramsDirty = false;
+    }
+}
+
+float SimpleReverbAudioProcessor::getDuckGain(float envelope, float amount, float thresholdDb)
+{
+    if (amount <= 0.f) { return 1.f; }
+
+    auto envelopeDb = juce::Decibels::gainToDecibels(envelope);
+    auto depth = juce::jlimit(0.f, 1.f, (envelopeDb - thresholdDb + duckKneeDb) / duckKneeDb);
+
+    return juce::Decibels::decibelsToGain(-duckRangeDb * amount * depth);
+}
+
+bool SimpleReverbAudioProcessor::paramsEqual(const juce::Reverb::Parameters& a, const juce::Reverb::Parameters& b)
+{
+    return a.roomSize == b.roomSize && a.damping == b.damping && wetEqual(a.wetLevel, b.wetLevel)
+        && a.dryLevel == b.dryLevel && a.width == b.width && a.freezeMode == b.freezeMode;
+}
+
+bool SimpleReverbAudioProcessor::wetEqual(float a, float b)
+{
+    if (a == b) { return true; }
+
+    //hitting 0 or full scale always goes through, so a low Dry/Wet can't hold the gate half open
+    if (a <= 0.f || a >= 1.f || b <= 0.f) { return false; }
+
+    return std::abs(a - b) < b * wetTolerance;
+}
+
+void SimpleReverbAudioProcessor::syncGate()
+{
+    gateBpm = 120.0;
+
+    if (auto* playHead = getPlayHead()) {
+        if (auto position = playHead->getPosition()) {
+            if (auto hostBpm = position->getBpm()) { gateBpm = *hostBpm; }
+
+            //while the host is playing the gate locks to its position, otherwise it free runs
+            if (auto ppq = position->getPpqPosition(); ppq && position->getIsPlaying()) {
+                gateBeats = *ppq;
+            }
+        }
+    }
+}
+
+void SimpleReverbAudioProcessor::advanceGate(int numSamples)
+{
+    gateBeats += numSamples * gateBpm / (60.0 * getSampleRate());
+}
+
+float SimpleReverbAudioProcessor::getGateGain(double beats, int division)
+{
+    //gate choices are Off, 1/4, 1/8 and 1/16, so each step halves the length in beats
+    if (division == 0) { return 1.f; }
+
+    auto stepBeats = 1.0 / (1 << (division - 1));
+
+    //ppq is negative during pre-roll and count-ins, so wrap back into [0, stepBeats) to keep the gate in phase
+    auto phase = std::fmod(beats, stepBeats);
+    if (phase < 0) { phase += stepBeats; }
+
+    return phase < stepBeats * .5 ? 1.f : 0.f;
 }
 
 //==============================================================================
@@ -219,18 +380,32 @@ float SimpleReverbAudioProcessor::getOutRMS(int channel)
     return rmsOut[channel];
 }
 
-juce::AudioProcessorValueTreeState::ParameterLayout SimpleReverbAudioProcessor::createParameterLayout()
+//adds the parameter to the layout and hands back its real type, so the handle is known at compile time
+template <typename ParamType, typename... Args>
+static ParamType* addTypedParameter(juce::AudioProcessorValueTreeState::ParameterLayout& layout, Args&&... args)
+{
+    auto param = std::make_unique<ParamType>(std::forward<Args>(args)...);
+    auto* handle = param.get();
+    layout.add(std::move(param));
+    return handle;
+}
+
+juce::AudioProcessorValueTreeState::ParameterLayout SimpleReverbAudioProcessor::createParameterLayout(ParameterRefs& refs)
 {
     using namespace juce;
     AudioProcessorValueTreeState::ParameterLayout layout;
 
     auto range = NormalisableRange<float>(0, 1, .01, 1);
 
-    layout.add(std::make_unique<AudioParameterFloat>("roomSize", "Room Size", range, .5));
-    layout.add(std::make_unique<AudioParameterFloat>("damping", "Damping", range, .5));
-    layout.add(std::make_unique<AudioParameterFloat>("dryWet", "Dry/Wet", range, .5));
-    layout.add(std::make_unique<AudioParameterFloat>("width", "Width", range, .5));
-    layout.add(std::make_unique<AudioParameterBool>("freeze", "Freeze", false));
+    refs.roomSize = addTypedParameter<AudioParameterFloat>(layout, "roomSize", "Room Size", range, .5);
+    refs.damping = addTypedParameter<AudioParameterFloat>(layout, "damping", "Damping", range, .5);
+    refs.dryWet = addTypedParameter<AudioParameterFloat>(layout, "dryWet", "Dry/Wet", range, .5);
+    refs.width = addTypedParameter<AudioParameterFloat>(layout, "width", "Width", range, .5);
+    refs.freeze = addTypedParameter<AudioParameterBool>(layout, "freeze", "Freeze", false);
+    refs.duck = addTypedParameter<AudioParameterFloat>(layout, "duck", "Duck", range, 0);
+    refs.gate = addTypedParameter<AudioParameterChoice>(layout, "gate", "Gate", StringArray{ "Off", "1/4", "1/8", "1/16" }, 0);
+    refs.output = addTypedParameter<AudioParameterChoice>(layout, "output", "Output", StringArray{ "Stereo", "Binaural" }, 0);
+    refs.duckThreshold = addTypedParameter<AudioParameterFloat>(layout, "duckThreshold", "Duck Threshold", NormalisableRange<float>(-60, 0, 1, 1), -30);
 
     return layout;
 }
@@ -9,6 +9,7 @@
 #pragma once
 
 #include <JuceHeader.h>
+#include "SpatialRenderer.h"
 
 //==============================================================================
 /**
@@ -59,22 +60,105 @@ public:
     float getRMS(int channel);
     float getOutRMS(int channel);
 
-    static juce::AudioProcessorValueTreeState::ParameterLayout createParameterLayout();
-    juce::AudioProcessorValueTreeState apvts{*this, nullptr, "parameters", createParameterLayout()};
+    //ducking works on the envelope in dB, it fades in over the knee below the threshold and
+    //reaches Duck times the full range once the input is at or above it
+    static constexpr float duckRangeDb = 36.f;
+    static constexpr float duckKneeDb = 12.f;
+    static float getDuckGain(float envelope, float amount, float thresholdDb);
+
+    //gate gain at a position in beats, division is the Gate choice index (0 is Off)
+    static float getGateGain(double beats, int division);
+
+    //typed handles, filled in while the layout is built so no lookups or casts are needed afterwards.
+    //has to be declared before apvts so it is initialised first.
+    struct ParameterRefs
+    {
+        juce::AudioParameterFloat* roomSize{ nullptr };
+        juce::AudioParameterFloat* damping{ nullptr };
+        juce::AudioParameterFloat* dryWet{ nullptr };
+        juce::AudioParameterFloat* width{ nullptr };
+        juce::AudioParameterBool* freeze{ nullptr };
+        juce::AudioParameterFloat* duck{ nullptr };
+        juce::AudioParameterChoice* gate{ nullptr };
+        juce::AudioParameterChoice* output{ nullptr };
+        juce::AudioParameterFloat* duckThreshold{ nullptr };
+    };
+
+    static juce::AudioProcessorValueTreeState::ParameterLayout createParameterLayout(ParameterRefs& refs);
+
+private:
+    ParameterRefs paramRefs;
+
+public:
+    juce::AudioProcessorValueTreeState apvts{*this, nullptr, "parameters", createParameterLayout(paramRefs)};
 
 private:
 
     juce::dsp::Reverb reverb;
     juce::Reverb::Parameters params;
 
-    std::array<float, 2> rmsIn;
-    std::array<float, 2> rmsOut;
-
-    juce::AudioParameterFloat* roomSize{ nullptr };
-    juce::AudioParameterFloat* damping{ nullptr };
-    juce::AudioParameterFloat* dryWet{ nullptr };
-    juce::AudioParameterFloat* width{ nullptr };
-    juce::AudioParameterBool* freeze{ nullptr };
+    std::array<float, 2> rmsIn{ -60.f, -60.f };
+    std::array<float, 2> rmsOut{ -60.f, -60.f };
+
+    juce::AudioParameterFloat& roomSize{ *paramRefs.roomSize };
+    juce::AudioParameterFloat& damping{ *paramRefs.damping };
+    juce::AudioParameterFloat& dryWet{ *paramRefs.dryWet };
+    juce::AudioParameterFloat& width{ *paramRefs.width };
+    juce::AudioParameterBool& freeze{ *paramRefs.freeze };
+    juce::AudioParameterFloat& duck{ *paramRefs.duck };
+    juce::AudioParameterFloat& duckThreshold{ *paramRefs.duckThreshold };
+    juce::AudioParameterChoice& gate{ *paramRefs.gate };
+    juce::AudioParameterChoice& output{ *paramRefs.output };
+
+    //ambisonic encode or binaural render of the tank, depending on the output bus and the output parameter
+    SpatialRenderer spatial;
+
+    //largest block the reverb is ever handed, host blocks are split into pieces no bigger than this
+    static constexpr int maxSubBlockSize = 64;
+    int subBlockSize{ maxSubBlockSize };
+
+    //parameters, the playhead and the wet gain are refreshed every controlInterval samples rather than on
+    //every processBlock call, so a host sending tiny blocks doesn't pay for them each time
+    static constexpr int controlInterval = maxSubBlockSize;
+    int controlSamples{ 0 };
+    void readParameters();
+    void updateReverbParameters(float duckLevel);
+
+    //snapshot taken by readParameters, wetLevel is filled in per control tick
+    juce::Reverb::Parameters targetParams;
+    float dryWetLevel{ 0.f };
+    float duckAmount{ 0.f };
+    float duckThresholdDb{ 0.f };
+    int gateDivision{ 0 };
+    bool binaural{ false };
+
+    //the wet level moves with the ducking envelope, so steps under about 0.1dB are left to the reverb's own
+    //smoothing. It is relative so the bottom of the 36dB duck range still gets pushed.
+    static constexpr float wetTolerance = .0116f;
+    static bool wetEqual(float a, float b);
+    static bool paramsEqual(const juce::Reverb::Parameters& a, const juce::Reverb::Parameters& b);
+
+    //set when the reverb has to be handed the target parameters on the next control tick whether they moved or not
+    bool paramsDirty{ true };
+
+    //reads the host tempo and position, then the gate is stepped along per sub block
+    void syncGate();
+    void advanceGate(int numSamples);
+
+    //peak envelope of the input for ducking, one per channel
+    std::array<float, 2> duckEnv{ 0.f, 0.f };
+    float duckAttack{ 0.f };
+    float duckRelease{ 0.f };
+
+    //gate position in beats, follows the host when it is playing and free runs otherwise
+    double gateBeats{ 0.0 };
+    double gateBpm{ 120.0 };
+
+    //running sums for the meters so the dB conversion happens once per window rather than per block
+    std::array<float, 2> meterSumIn{ 0.f, 0.f };
+    std::array<float, 2> meterSumOut{ 0.f, 0.f };
+    int meterSamples{ 0 };
+    int meterWindow{ 1 };
     //==============================================================================
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (SimpleReverbAudioProcessor)
 };
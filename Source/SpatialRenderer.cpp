@@ -0,0 +1,182 @@
+/*
+  ==============================================================================
+
+    SpatialRenderer.cpp
+
+  ==============================================================================
+*/
+
+#include "SpatialRenderer.h"
+
+//real spherical harmonics up to third order, ACN channel order with SN3D normalisation (AmbiX)
+static std::array<float, SpatialRenderer::maxAmbisonicChannels> encodeDirection(float azimuth, float elevation)
+{
+    auto x = std::cos(elevation) * std::cos(azimuth);
+    auto y = std::cos(elevation) * std::sin(azimuth);
+    auto z = std::sin(elevation);
+
+    auto sqrt3 = std::sqrt(3.f);
+    auto sqrt15 = std::sqrt(15.f);
+
+    return {
+        1.f,
+        y, z, x,
+        sqrt3 * x * y, sqrt3 * y * z, .5f * (3 * z * z - 1), sqrt3 * x * z, sqrt3 * .5f * (x * x - y * y),
+        std::sqrt(5.f / 8.f) * y * (3 * x * x - y * y), sqrt15 * x * y * z, std::sqrt(3.f / 8.f) * y * (5 * z * z - 1),
+        .5f * z * (5 * z * z - 3), std::sqrt(3.f / 8.f) * x * (5 * z * z - 1), sqrt15 * .5f * z * (x * x - y * y),
+        std::sqrt(5.f / 8.f) * x * (x * x - 3 * y * y)
+    };
+}
+
+void SpatialRenderer::prepare(double sampleRate, int maxBlockSize, int numSources, int ambisonicOrder)
+{
+    using namespace juce;
+
+    jassert(numSources == 1 || numSources == 2);
+    jassert(ambisonicOrder <= maxAmbisonicOrder);
+
+    order = ambisonicOrder;
+    sources = numSources;
+
+    //stereo tank outputs go out at 45 degrees either side of the front, a mono tank goes straight ahead
+    auto left = encodeDirection(sources == 1 ? 0.f : MathConstants<float>::pi * .25f, 0.f);
+    auto right = encodeDirection(-MathConstants<float>::pi * .25f, 0.f);
+
+    for (auto channel = 0; channel < maxAmbisonicChannels; channel++) {
+        encodingMatrix[channel] = { left[channel], right[channel] };
+    }
+
+    scratch.setSize(2, maxBlockSize, false, false, true);
+
+    canRenderBinaural = order <= 0 && sources == 2;
+    if (!canRenderBinaural) {
+        return;
+    }
+
+    //virtual speakers at +-30 degrees, the far ear hears them late by the Woodworth ITD
+    auto speakerAngle = MathConstants<float>::pi / 6.f;
+    auto headRadius = .0875f;
+    auto speedOfSound = 343.f;
+    auto itd = headRadius / speedOfSound * (speakerAngle + std::sin(speakerAngle)) * (float)sampleRate;
+
+    itdIndex = (int)itd;
+    itdFrac = itd - itdIndex;
+    itdDelay.setSize(2, nextPowerOfTwo(itdIndex + 2));
+
+    //keeps the overall power close to the plain stereo path
+    auto gain = MathConstants<float>::sqrt2 * .5f;
+    auto nearEar = makeHeadShadow(sampleRate, MathConstants<float>::halfPi - speakerAngle, gain);
+    auto farEar = makeHeadShadow(sampleRate, MathConstants<float>::halfPi + speakerAngle, gain);
+
+    ipsilateral = { nearEar, nearEar };
+    contralateral = { farEar, farEar };
+
+    resetBinaural();
+}
+
+void SpatialRenderer::reset()
+{
+    wasBinaural = false;
+    resetBinaural();
+}
+
+void SpatialRenderer::resetBinaural()
+{
+    for (auto& filter : ipsilateral) { filter.reset(); }
+    for (auto& filter : contralateral) { filter.reset(); }
+
+    itdDelay.clear();
+    itdWrite = 0;
+}
+
+void SpatialRenderer::process(juce::dsp::AudioBlock<float> block, bool binaural)
+{
+    if (order > 0) {
+        encodeAmbisonic(block);
+    }
+    else if (binaural && canRenderBinaural && block.getNumChannels() == 2) {
+        //the filters sat idle while binaural was off, so clear them before the old state is replayed
+        if (!wasBinaural) {
+            resetBinaural();
+        }
+
+        renderBinaural(block);
+        wasBinaural = true;
+        return;
+    }
+
+    wasBinaural = false;
+}
+
+void SpatialRenderer::encodeAmbisonic(juce::dsp::AudioBlock<float> block)
+{
+    using namespace juce;
+
+    auto numSamples = (int)block.getNumSamples();
+    auto numChannels = jmin((int)block.getNumChannels(), (order + 1) * (order + 1));
+
+    //the tank outputs live in the channels we are about to write over
+    for (auto source = 0; source < sources; source++) {
+        FloatVectorOperations::copy(scratch.getWritePointer(source), block.getChannelPointer(source), numSamples);
+    }
+
+    for (auto channel = 0; channel < numChannels; channel++) {
+        auto* out = block.getChannelPointer(channel);
+        FloatVectorOperations::copyWithMultiply(out, scratch.getReadPointer(0), encodingMatrix[channel][0], numSamples);
+
+        if (sources == 2) {
+            FloatVectorOperations::addWithMultiply(out, scratch.getReadPointer(1), encodingMatrix[channel][1], numSamples);
+        }
+    }
+}
+
+void SpatialRenderer::renderBinaural(juce::dsp::AudioBlock<float> block)
+{
+    auto numSamples = (int)block.getNumSamples();
+    auto* left = block.getChannelPointer(0);
+    auto* right = block.getChannelPointer(1);
+
+    auto* delayLeft = itdDelay.getWritePointer(0);
+    auto* delayRight = itdDelay.getWritePointer(1);
+    auto mask = itdDelay.getNumSamples() - 1;
+
+    for (auto i = 0; i < numSamples; i++) {
+        auto l = left[i];
+        auto r = right[i];
+
+        delayLeft[itdWrite] = l;
+        delayRight[itdWrite] = r;
+
+        auto tap = (itdWrite - itdIndex) & mask;
+        auto nextTap = (tap - 1) & mask;
+        auto lateLeft = delayLeft[tap] * (1.f - itdFrac) + delayLeft[nextTap] * itdFrac;
+        auto lateRight = delayRight[tap] * (1.f - itdFrac) + delayRight[nextTap] * itdFrac;
+
+        //each ear hears its own speaker directly and the opposite one late and shadowed
+        left[i] = ipsilateral[0].process(l) + contralateral[1].process(lateRight);
+        right[i] = ipsilateral[1].process(r) + contralateral[0].process(lateLeft);
+
+        itdWrite = (itdWrite + 1) & mask;
+    }
+}
+
+SpatialRenderer::HeadShadow SpatialRenderer::makeHeadShadow(double sampleRate, float earAngle, float gain)
+{
+    using namespace juce;
+
+    auto alphaMin = .1f;
+    auto thetaMin = MathConstants<float>::pi * 150.f / 180.f;
+    auto alpha = (1.f + alphaMin / 2) + (1.f - alphaMin / 2) * std::cos(earAngle / thetaMin * MathConstants<float>::pi);
+
+    auto headRadius = .0875f;
+    auto speedOfSound = 343.f;
+    auto tau = headRadius / (2.f * speedOfSound);
+    auto k = 2.f * (float)sampleRate;
+
+    //bilinear transform of (1 + alpha tau s) / (1 + tau s)
+    HeadShadow filter;
+    filter.b0 = gain * (1.f + alpha * tau * k) / (1.f + tau * k);
+    filter.b1 = gain * (1.f - alpha * tau * k) / (1.f + tau * k);
+    filter.a1 = (1.f - tau * k) / (1.f + tau * k);
+    return filter;
+}
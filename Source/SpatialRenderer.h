@@ -0,0 +1,71 @@
+/*
+  ==============================================================================
+
+    SpatialRenderer.h
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <JuceHeader.h>
+
+//Takes the reverb's output channels and renders them either to an ambisonic bus or to binaural stereo.
+//Everything is worked out in prepare so the audio thread only does vector adds or a handful of filters per sample.
+struct SpatialRenderer {
+
+    static constexpr int maxAmbisonicOrder = 3;
+    static constexpr int maxAmbisonicChannels = (maxAmbisonicOrder + 1) * (maxAmbisonicOrder + 1);
+
+    //ambisonicOrder is -1 when the output is plain mono/stereo
+    void prepare(double sampleRate, int maxBlockSize, int numSources, int ambisonicOrder);
+    void reset();
+
+    //the reverb output sits in the first numSources channels of block and is replaced in place
+    void process(juce::dsp::AudioBlock<float> block, bool binaural);
+
+private:
+    void encodeAmbisonic(juce::dsp::AudioBlock<float> block);
+    void renderBinaural(juce::dsp::AudioBlock<float> block);
+
+    //Brown-Duda spherical head shadow for one ear, a one pole one zero filter that boosts the near ear and dulls the far one
+    struct HeadShadow
+    {
+        float b0{ 1.f }, b1{ 0.f }, a1{ 0.f };
+        float lastIn{ 0.f }, lastOut{ 0.f };
+
+        float process(float in)
+        {
+            auto out = b0 * in + b1 * lastIn - a1 * lastOut;
+            lastIn = in;
+            lastOut = out;
+            return out;
+        }
+
+        void reset() { lastIn = lastOut = 0.f; }
+    };
+
+    //angle is between the source and that ear's axis
+    static HeadShadow makeHeadShadow(double sampleRate, float earAngle, float gain);
+    void resetBinaural();
+
+    int order{ -1 };
+    int sources{ 2 };
+
+    //ACN/SN3D gains, one row per ambisonic channel and one column per tank output
+    std::array<std::array<float, 2>, maxAmbisonicChannels> encodingMatrix{};
+
+    juce::AudioBuffer<float> scratch;
+
+    //only a stereo output can be rendered binaurally
+    bool canRenderBinaural{ false };
+    bool wasBinaural{ false };
+
+    //speakers are placed symmetrically, so both sides share coefficients, index is the speaker the filter hears
+    std::array<HeadShadow, 2> ipsilateral, contralateral;
+
+    //the far ear hears each speaker late by the interaural time difference, split across two taps
+    juce::AudioBuffer<float> itdDelay;
+    int itdWrite{ 0 };
+    int itdIndex{ 0 };
+    float itdFrac{ 0.f };
+};
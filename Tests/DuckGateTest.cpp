@@ -0,0 +1,65 @@
+/*
+  ==============================================================================
+
+    DuckGateTest.cpp
+    Checks the ducking law and the tempo gate phase.
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include "../Source/PluginProcessor.h"
+
+struct DuckGateTest : juce::UnitTest
+{
+    DuckGateTest() : juce::UnitTest("Duck and gate", "Processor") {}
+
+    static float duckDb(float inputDb, float amount, float thresholdDb)
+    {
+        auto gain = SimpleReverbAudioProcessor::getDuckGain(juce::Decibels::decibelsToGain(inputDb), amount, thresholdDb);
+        return juce::Decibels::gainToDecibels(gain);
+    }
+
+    void runTest() override
+    {
+        using Processor = SimpleReverbAudioProcessor;
+
+        beginTest("Ducking above the threshold");
+        //a normal program peak well over the threshold gets the full range scaled by Duck
+        expectWithinAbsoluteError(duckDb(-18.f, 1.f, -30.f), -Processor::duckRangeDb, .01f);
+        expectWithinAbsoluteError(duckDb(-18.f, .5f, -30.f), -Processor::duckRangeDb * .5f, .01f);
+        expectWithinAbsoluteError(duckDb(-30.f, 1.f, -30.f), -Processor::duckRangeDb, .01f);
+
+        beginTest("Ducking below the threshold");
+        expectWithinAbsoluteError(duckDb(-30.f - Processor::duckKneeDb - 1.f, 1.f, -30.f), 0.f, .01f);
+        expectWithinAbsoluteError(duckDb(-30.f - Processor::duckKneeDb * .5f, 1.f, -30.f), -Processor::duckRangeDb * .5f, .01f);
+        expectWithinAbsoluteError(duckDb(0.f, 0.f, -30.f), 0.f, .01f);
+
+        beginTest("Gate off");
+        expectEquals(Processor::getGateGain(-.3, 0), 1.f);
+        expectEquals(Processor::getGateGain(.3, 0), 1.f);
+
+        beginTest("Gate phase");
+        //1/8 steps are half a beat, open for the first quarter beat of each
+        expectEquals(Processor::getGateGain(0.0, 2), 1.f);
+        expectEquals(Processor::getGateGain(.1, 2), 1.f);
+        expectEquals(Processor::getGateGain(.3, 2), 0.f);
+        expectEquals(Processor::getGateGain(.6, 2), 1.f);
+
+        beginTest("Gate phase during pre-roll");
+        //negative ppq has to land on the same grid as positive ppq
+        expectEquals(Processor::getGateGain(-.1, 2), 0.f);
+        expectEquals(Processor::getGateGain(-.4, 2), 1.f);
+        expectEquals(Processor::getGateGain(-1.9, 1), 1.f);
+        expectEquals(Processor::getGateGain(-1.4, 1), 0.f);
+
+        for (auto division = 1; division <= 3; division++) {
+            for (auto beats = -4.0; beats < 4.0; beats += .03125) {
+                auto step = 1.0 / (1 << (division - 1));
+                expectEquals(Processor::getGateGain(beats, division), Processor::getGateGain(beats + step * 8, division));
+            }
+        }
+    }
+};
+
+static DuckGateTest duckGateTest;
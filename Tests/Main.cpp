@@ -0,0 +1,29 @@
+/*
+  ==============================================================================
+
+    Main.cpp
+    Runs every juce::UnitTest linked into the test app and returns non zero on failure.
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+
+int main (int argc, char* argv[])
+{
+    juce::ignoreUnused (argc, argv);
+
+    //the editor tests build real components, so this needs the GUI side of juce up
+    juce::ScopedJuceInitialiser_GUI juceInit;
+
+    juce::UnitTestRunner runner;
+    runner.setAssertOnFailure(false);
+    runner.runAllTests();
+
+    auto failures = 0;
+    for (auto i = 0; i < runner.getNumResults(); i++) {
+        failures += runner.getResult(i)->failures;
+    }
+
+    return failures > 0 ? 1 : 0;
+}
@@ -0,0 +1,156 @@
+/*
+  ==============================================================================
+
+    RenderBudgetTest.cpp
+    Times processBlock for each output mode against the plain stereo path.
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include "../Source/PluginProcessor.h"
+
+struct RenderBudgetTest : juce::UnitTest
+{
+    RenderBudgetTest() : juce::UnitTest("Render budget", "Benchmarks") {}
+
+    static constexpr double sampleRate = 48000.0;
+    static constexpr int blockSize = 512;
+    static constexpr int warmUpBlocks = 500;
+    static constexpr int rounds = 7;
+    static constexpr int blocksPerRound = 300;
+
+    std::unique_ptr<SimpleReverbAudioProcessor> makeProcessor(const juce::AudioChannelSet& outputSet, bool binaural)
+    {
+        auto processor = std::make_unique<SimpleReverbAudioProcessor>();
+
+        SimpleReverbAudioProcessor::BusesLayout layout;
+        layout.inputBuses.add(juce::AudioChannelSet::stereo());
+        layout.outputBuses.add(outputSet);
+        expect(processor->setBusesLayout(layout));
+
+        processor->apvts.getParameter("output")->setValueNotifyingHost(binaural ? 1.f : 0.f);
+        processor->setRateAndBufferSizeDetails(sampleRate, blockSize);
+        processor->prepareToPlay(sampleRate, blockSize);
+        return processor;
+    }
+
+    //microseconds per host block, the fastest round is kept so a busy machine only ever makes it look worse once
+    double timeMode(const juce::AudioChannelSet& outputSet, bool binaural)
+    {
+        auto processor = makeProcessor(outputSet, binaural);
+
+        juce::AudioBuffer<float> buffer(outputSet.size(), blockSize);
+        juce::MidiBuffer midi;
+        juce::Random random(1);
+
+        auto fill = [&] {
+            buffer.clear();
+            for (auto channel = 0; channel < 2; channel++) {
+                for (auto i = 0; i < blockSize; i++) {
+                    buffer.setSample(channel, i, random.nextFloat() * .5f - .25f);
+                }
+            }
+        };
+
+        for (auto i = 0; i < warmUpBlocks; i++) {
+            fill();
+            processor->processBlock(buffer, midi);
+        }
+
+        auto best = std::numeric_limits<double>::max();
+        for (auto round = 0; round < rounds; round++) {
+            juce::int64 ticks = 0;
+            for (auto i = 0; i < blocksPerRound; i++) {
+                fill();
+                auto start = juce::Time::getHighResolutionTicks();
+                processor->processBlock(buffer, midi);
+                ticks += juce::Time::getHighResolutionTicks() - start;
+            }
+
+            best = juce::jmin(best, juce::Time::highResolutionTicksToSeconds(ticks) * 1.0e6 / blocksPerRound);
+        }
+
+        processor->releaseResources();
+        return best;
+    }
+
+    //sends a unit impulse through one input side with the reverb fully dry and returns the first output sample per channel
+    std::vector<float> impulseResponse(const juce::AudioChannelSet& outputSet, int inputChannel)
+    {
+        auto processor = makeProcessor(outputSet, false);
+        processor->apvts.getParameter("dryWet")->setValueNotifyingHost(0.f);
+
+        juce::AudioBuffer<float> buffer(outputSet.size(), blockSize);
+        juce::MidiBuffer midi;
+
+        //let the reverb's 10ms gain ramps settle on silence first
+        for (auto i = 0; i < 10; i++) {
+            buffer.clear();
+            processor->processBlock(buffer, midi);
+        }
+
+        buffer.clear();
+        buffer.setSample(inputChannel, 0, 1.f);
+        processor->processBlock(buffer, midi);
+
+        std::vector<float> response;
+        for (auto channel = 0; channel < buffer.getNumChannels(); channel++) {
+            response.push_back(buffer.getSample(channel, 0));
+        }
+
+        processor->releaseResources();
+        return response;
+    }
+
+    void runTest() override
+    {
+        beginTest("First order encoding");
+        {
+            //ACN order is W, Y, Z, X with SN3D gains, the left side sits at +45 degrees and the right at -45
+            auto sin45 = std::sin(juce::MathConstants<float>::pi * .25f);
+            auto cos45 = std::cos(juce::MathConstants<float>::pi * .25f);
+
+            for (auto side : { 0, 1 }) {
+                auto response = impulseResponse(juce::AudioChannelSet::ambisonic(1), side);
+                expectEquals((int)response.size(), 4);
+
+                auto w = response[0];
+                expect(w > .1f, "the dry impulse should reach W");
+
+                auto sign = side == 0 ? 1.f : -1.f;
+                expectWithinAbsoluteError(response[1] / w, sign * sin45, 1.0e-4f);
+                expectWithinAbsoluteError(response[2] / w, 0.f, 1.0e-4f);
+                expectWithinAbsoluteError(response[3] / w, cos45, 1.0e-4f);
+            }
+        }
+
+        beginTest("Output modes against the stereo path");
+
+        auto stereoUs = timeMode(juce::AudioChannelSet::stereo(), false);
+        auto binauralUs = timeMode(juce::AudioChannelSet::stereo(), true);
+        auto firstOrderUs = timeMode(juce::AudioChannelSet::ambisonic(1), false);
+        auto thirdOrderUs = timeMode(juce::AudioChannelSet::ambisonic(3), false);
+
+        auto report = [this, stereoUs](const juce::String& name, double us) {
+            logMessage(name + ": " + juce::String(us, 2) + " us per " + juce::String(blockSize) + " sample block, "
+                + juce::String(us / stereoUs, 2) + "x stereo");
+        };
+
+        report("stereo", stereoUs);
+        report("binaural", binauralUs);
+        report("ambisonic 1st order", firstOrderUs);
+        report("ambisonic 3rd order", thirdOrderUs);
+
+       #if ! JUCE_DEBUG
+        //encoding is a couple of vector multiply adds per channel and binaural is four one pole filters and
+        //a short delay per sample, so all of them have to stay in the stereo path's budget.
+        //Debug builds only log, unoptimised code doesn't keep the same proportions.
+        expectLessThan(firstOrderUs / stereoUs, 1.25);
+        expectLessThan(thirdOrderUs / stereoUs, 1.5);
+        expectLessThan(binauralUs / stereoUs, 1.25);
+       #endif
+    }
+};
+
+static RenderBudgetTest renderBudgetTest;
@@ -0,0 +1,86 @@
+/*
+  ==============================================================================
+
+    SchedulerTest.cpp
+    Checks that host block size doesn't change what the reverb produces.
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include "../Source/PluginProcessor.h"
+
+struct SchedulerTest : juce::UnitTest
+{
+    SchedulerTest() : juce::UnitTest("Block scheduler", "Processor") {}
+
+    static constexpr double sampleRate = 48000.0;
+    static constexpr int totalSamples = 4096;
+
+    static juce::AudioBuffer<float> makeInput()
+    {
+        juce::AudioBuffer<float> input(2, totalSamples);
+        juce::Random random(1);
+
+        for (auto channel = 0; channel < input.getNumChannels(); channel++) {
+            for (auto i = 0; i < totalSamples; i++) {
+                input.setSample(channel, i, random.nextFloat() * .5f - .25f);
+            }
+        }
+
+        return input;
+    }
+
+    //runs the input through a fresh processor prepared for preparedSize, in host blocks of blockSize
+    static juce::AudioBuffer<float> render(const juce::AudioBuffer<float>& input, int preparedSize, int blockSize)
+    {
+        SimpleReverbAudioProcessor processor;
+        processor.setRateAndBufferSizeDetails(sampleRate, preparedSize);
+        processor.prepareToPlay(sampleRate, preparedSize);
+
+        juce::AudioBuffer<float> output(input);
+        juce::MidiBuffer midi;
+
+        for (auto offset = 0; offset < totalSamples; offset += blockSize) {
+            auto length = juce::jmin(blockSize, totalSamples - offset);
+            juce::AudioBuffer<float> hostBlock(output.getArrayOfWritePointers(), output.getNumChannels(), offset, length);
+            processor.processBlock(hostBlock, midi);
+        }
+
+        processor.releaseResources();
+        return output;
+    }
+
+    float maxDifference(const juce::AudioBuffer<float>& a, const juce::AudioBuffer<float>& b)
+    {
+        auto difference = 0.f;
+        for (auto channel = 0; channel < a.getNumChannels(); channel++) {
+            for (auto i = 0; i < a.getNumSamples(); i++) {
+                expect(std::isfinite(a.getSample(channel, i)));
+                difference = juce::jmax(difference, std::abs(a.getSample(channel, i) - b.getSample(channel, i)));
+            }
+        }
+
+        return difference;
+    }
+
+    void runTest() override
+    {
+        auto input = makeInput();
+
+        beginTest("Host block larger than prepared");
+        //a 4096 sample block after preparing for 32 has to come out exactly as if the host had kept to 32
+        auto oversized = render(input, 32, totalSamples);
+        auto reference = render(input, 32, 32);
+        expectLessThan(maxDifference(oversized, reference), 1.0e-6f);
+
+        beginTest("Host block sizes");
+        auto full = render(input, 512, 512);
+        for (auto blockSize : { 1, 17, 64 }) {
+            auto split = render(input, 512, blockSize);
+            expectLessThan(maxDifference(split, full), 1.0e-5f, "block size " + juce::String(blockSize));
+        }
+    }
+};
+
+static SchedulerTest schedulerTest;
@@ -0,0 +1,92 @@
+/*
+  ==============================================================================
+
+    StartupBenchmark.cpp
+    Times processor and editor construction, which is what a host pays for
+    every instance when a session opens.
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include "../Source/PluginProcessor.h"
+#include "../Source/PluginEditor.h"
+
+struct StartupBenchmark : juce::UnitTest
+{
+    StartupBenchmark() : juce::UnitTest("Startup", "Benchmarks") {}
+
+    static constexpr int iterations = 100;
+
+    //wall clock numbers swing too much between machines and build configs to assert on,
+    //so this only logs the new paths next to the old ones they replaced
+
+    template <typename Fn>
+    static double averageMs(Fn&& fn)
+    {
+        juce::int64 ticks = 0;
+        for (auto i = 0; i < iterations; i++) {
+            ticks += fn();
+        }
+
+        return juce::Time::highResolutionTicksToSeconds(ticks) * 1000.0 / iterations;
+    }
+
+    template <typename Fn>
+    static juce::int64 timed(Fn&& fn)
+    {
+        auto start = juce::Time::getHighResolutionTicks();
+        fn();
+        return juce::Time::getHighResolutionTicks() - start;
+    }
+
+    void runTest() override
+    {
+        beginTest("Processor construction");
+        auto processorMs = averageMs([] {
+            return timed([] { SimpleReverbAudioProcessor processor; });
+        });
+        logMessage("processor: " + juce::String(processorMs, 3) + " ms");
+
+        beginTest("Parameter lookup");
+        SimpleReverbAudioProcessor processor;
+        auto lookupMs = averageMs([&processor] {
+            //what the constructor used to do before the handles came out of the layout
+            return timed([&processor] {
+                for (auto* id : { "roomSize", "damping", "dryWet", "width" }) {
+                    auto* param = dynamic_cast<juce::AudioParameterFloat*>(processor.apvts.getParameter(id));
+                    juce::ignoreUnused(param);
+                }
+                auto* freeze = dynamic_cast<juce::AudioParameterBool*>(processor.apvts.getParameter("freeze"));
+                juce::ignoreUnused(freeze);
+            });
+        });
+        logMessage("dynamic_cast lookups (previous constructor): " + juce::String(lookupMs * 1000.0, 3) + " us");
+
+        beginTest("Editor construction");
+        auto editorMs = averageMs([&processor] {
+            std::unique_ptr<juce::AudioProcessorEditor> editor;
+            //only the construction is timed, closing the editor waits for its asset thread
+            return timed([&] { editor.reset(processor.createEditor()); });
+        });
+        logMessage("editor: " + juce::String(editorMs, 3) + " ms");
+
+        beginTest("Synchronous asset decode");
+        auto decodeMs = averageMs([] {
+            //what every paint used to do on the message thread, ImageCache is skipped so each run really decodes
+            return timed([] {
+                auto logo = juce::ImageFileFormat::loadFrom(BinaryData::KITIK_LOGO_NO_BKGD_png, BinaryData::KITIK_LOGO_NO_BKGD_pngSize);
+                auto typeface = juce::Typeface::createSystemTypefaceFor(BinaryData::OFFSHORE_TTF, BinaryData::OFFSHORE_TTFSize);
+                juce::ignoreUnused(logo, typeface);
+            });
+        });
+        logMessage("logo and font decode (previous paint path): " + juce::String(decodeMs, 3) + " ms");
+
+        //the old constructor did the lookups on top of everything else, and the old editor decoded
+        //both assets on the message thread before its first frame could show
+        logMessage("processor old vs new: " + juce::String(processorMs + lookupMs, 3) + " ms -> " + juce::String(processorMs, 3) + " ms");
+        logMessage("editor to first frame old vs new: " + juce::String(editorMs + decodeMs, 3) + " ms -> " + juce::String(editorMs, 3) + " ms");
+    }
+};
+
+static StartupBenchmark startupBenchmark;